@@ -0,0 +1,440 @@
+#pragma once
+// ============================================================================
+// SYNTHETIC CAMPUS GENERATOR
+// ============================================================================
+//
+// Seeded residence-life data for benchmarks and load tests, from a single
+// floor (about 50 residents) to a whole university system (100k). The same
+// config and seed produce the same residents on every platform: sampling
+// uses its own generator instead of the implementation-defined std::
+// distributions.
+//
+// What the data looks like:
+//   - Housing: buildings of up to 9 floors, rooms numbered floor*100 + n,
+//     mostly doubles with some singles, filled in roster order.
+//   - Classes: a department catalog sized for the whole student body, not
+//     just residents, with Zipf course popularity. Half of each resident's
+//     classes come from their major. Courses are split into sections
+//     ("MATH-101-02") with MWF, MW or TTh meeting patterns, and no
+//     resident has two sections at the same time.
+//   - Interests: campus clubs grouped into themes. Residents mostly join
+//     clubs of their primary theme; club popularity within a theme is Zipf.
+//   - Subcommunities: STEM, athletes, gamers, music, arts, honors,
+//     international, first_gen. Labels correlate with majors and themes,
+//     so groups overlap the way real ones do.
+//   - Free blocks: a few 1-2.5 hour windows, mostly evenings, that avoid the
+//     resident's classes. Some residents leave availability blank.
+//   - Check-ins: ratings, follow-up flags and concerns, with follow-ups
+//     more likely after low ratings.
+
+#include "community_homology_engine.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace community_homology {
+namespace bench {
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+enum class RoomFormat {
+    NUMBER_FIRST,    // "314-B02": the engine sees room 314 in every building
+    BUILDING_FIRST   // "B02-314": no room number, so no floor proximity
+};
+
+struct CampusConfig {
+    size_t residents = 1000;
+    size_t students = 0;                    // Enrolled, resident or not; 0 = max(20000, 3 * residents)
+    uint64_t seed = 1;
+    uint32_t id_base = 100000;              // SIS-style ids; 0 gives ids 0..V-1
+
+    // Housing
+    size_t rooms_per_floor = 24;            // At most 99
+    size_t floors_per_building = 7;         // At most 9
+    double single_room_rate = 0.15;
+    RoomFormat room_format = RoomFormat::NUMBER_FIRST;
+
+    // Academics
+    size_t min_classes = 3;
+    size_t max_classes = 5;
+    double course_zipf = 0.9;
+    double major_class_rate = 0.5;
+    size_t course_size = 45;                // Average enrollment, sizes the catalog
+    size_t section_capacity = 40;           // Sections per course follow expected enrollment
+    size_t lecture_capacity = 150;          // For the top 2% of courses
+
+    // Interests
+    size_t clubs_per_resident = 2;          // Average is this plus a half
+    size_t club_size = 30;                  // Average membership, sizes the club list
+    double club_zipf = 0.7;
+    double off_theme_rate = 0.2;
+
+    // Availability
+    size_t min_free_blocks = 1;
+    size_t max_free_blocks = 3;
+    double blank_availability_rate = 0.25;
+
+    // Check-ins
+    double follow_up_rate = 0.05;
+    double low_rating_follow_up_rate = 0.4;
+
+    // A config for the given population. The engine reads only the leading
+    // room number, so with shared numbers every "314" on campus would be a
+    // floor neighbor; past one building rooms are named building-first.
+    static CampusConfig scaled(size_t residents, uint64_t seed = 1) {
+        CampusConfig c;
+        c.residents = residents;
+        c.seed = seed;
+        double beds = c.rooms_per_floor * c.floors_per_building * (2.0 - c.single_room_rate);
+        if (residents > beds) {
+            c.room_format = RoomFormat::BUILDING_FIRST;
+        }
+        return c;
+    }
+};
+
+// Named populations
+constexpr size_t kFloorResidents = 50;
+constexpr size_t kBuildingResidents = 300;
+constexpr size_t kCampusResidents = 5000;
+constexpr size_t kSystemResidents = 100000;
+
+// ============================================================================
+// GENERATOR
+// ============================================================================
+
+class CampusGenerator {
+public:
+    explicit CampusGenerator(CampusConfig config) : cfg(std::move(config)), rng(cfg.seed) {
+        cfg.rooms_per_floor = std::clamp<size_t>(cfg.rooms_per_floor, 1, 99);
+        cfg.floors_per_building = std::clamp<size_t>(cfg.floors_per_building, 1, 9);
+        cfg.max_classes = std::max(cfg.min_classes, cfg.max_classes);
+        cfg.max_free_blocks = std::max(cfg.min_free_blocks, cfg.max_free_blocks);
+        if (cfg.students == 0) cfg.students = std::max<size_t>(20000, 3 * cfg.residents);
+        build_catalog();
+        build_clubs();
+    }
+
+    std::vector<Resident> residents() {
+        std::vector<Resident> out(cfg.residents);
+        Housing housing;
+        for (size_t i = 0; i < out.size(); ++i) fill(out[i], i, housing);
+        return out;
+    }
+
+    CommunityGraph graph() {
+        CommunityGraph G;
+        for (auto& r : residents()) {
+            G.emplace_resident([&](Resident& slot) { slot = std::move(r); });
+        }
+        return G;
+    }
+
+private:
+    // SplitMix64: small, fast and identical everywhere
+    struct Rng {
+        uint64_t state;
+        explicit Rng(uint64_t seed) : state(seed) {}
+
+        uint64_t next() {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+        double real() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+        size_t below(size_t n) { return n ? static_cast<size_t>(next() % n) : 0; }
+        size_t between(size_t lo, size_t hi) { return lo + below(hi - lo + 1); }
+        bool chance(double p) { return real() < p; }
+    };
+
+    // Rank k (0-based) drawn with weight 1/(k+1)^s
+    struct Zipf {
+        std::vector<double> cdf;
+
+        Zipf() = default;
+        Zipf(size_t n, double s) : cdf(n) {
+            double total = 0.0;
+            for (size_t k = 0; k < n; ++k) cdf[k] = (total += 1.0 / std::pow(k + 1.0, s));
+            for (auto& c : cdf) c /= total;
+        }
+        size_t operator()(Rng& rng) const {
+            auto it = std::upper_bound(cdf.begin(), cdf.end(), rng.real());
+            return std::min<size_t>(it - cdf.begin(), cdf.size() - 1);
+        }
+    };
+
+    struct Department {
+        const char* code;
+        bool stem;
+        std::vector<uint32_t> courses;      // By global popularity
+        Zipf popularity;
+    };
+
+    struct Course {
+        std::string code;
+        uint32_t department;
+        size_t sections;
+    };
+
+    struct Theme {
+        const char* name;
+        Zipf popularity;
+    };
+
+    struct Housing {
+        size_t room = 0;        // Rooms opened so far
+        size_t occupants = 0;   // In the current room
+        size_t capacity = 0;
+        std::string label;
+    };
+
+    CampusConfig cfg;
+    Rng rng;
+    std::vector<Department> departments;
+    std::vector<Course> courses;
+    Zipf course_popularity;
+    Zipf major_popularity;
+    std::vector<Theme> themes;
+    Zipf theme_popularity;
+    std::unordered_map<std::string, std::vector<TimeBlock>> meetings;
+
+    static constexpr uint16_t kDayStart = 8 * 60;
+    static constexpr uint16_t kDayEnd = 22 * 60;
+
+    void build_catalog() {
+        static const std::pair<const char*, bool> kDepartments[] = {
+            {"BIO", true}, {"CS", true}, {"MATH", true}, {"PSYC", false},
+            {"BUS", false}, {"ENGR", true}, {"ECON", false}, {"CHEM", true},
+            {"ENGL", false}, {"NURS", true}, {"COMM", false}, {"POLS", false},
+            {"HIST", false}, {"PHYS", true}, {"SOC", false}, {"ART", false},
+            {"MUS", false}, {"PHIL", false},
+        };
+        for (const auto& [code, stem] : kDepartments) departments.push_back({code, stem, {}, {}});
+
+        size_t avg_classes = (cfg.min_classes + cfg.max_classes + 1) / 2;
+        size_t wanted = cfg.students * avg_classes / std::max<size_t>(cfg.course_size, 1);
+        size_t count = std::clamp<size_t>(wanted, departments.size() * 4, departments.size() * 900);
+
+        // Popularity rank r belongs to a shuffled department, so every
+        // department has a few big courses and a long tail
+        std::vector<uint32_t> owner(count);
+        for (size_t k = 0; k < count; ++k) owner[k] = static_cast<uint32_t>(k % departments.size());
+        for (size_t k = count; k > 1; --k) std::swap(owner[k - 1], owner[rng.below(k)]);
+
+        // Residents are a slice of the student body, so a section holds
+        // only a few of them even in the most popular courses
+        course_popularity = Zipf(count, cfg.course_zipf);
+        size_t lectures = count / 50;
+        double seats = static_cast<double>(cfg.students * avg_classes);
+        for (size_t k = 0; k < count; ++k) {
+            Department& d = departments[owner[k]];
+            std::string code = std::string(d.code) + "-" + std::to_string(100 + d.courses.size());
+            d.courses.push_back(static_cast<uint32_t>(k));
+
+            const auto& cdf = course_popularity.cdf;
+            double expected = seats * (cdf[k] - (k ? cdf[k - 1] : 0.0));
+            size_t capacity = std::max<size_t>(k < lectures ? cfg.lecture_capacity : cfg.section_capacity, 1);
+            size_t sections = std::max<size_t>(1, static_cast<size_t>(std::ceil(expected / capacity)));
+            courses.push_back({std::move(code), owner[k], sections});
+        }
+        for (auto& d : departments) d.popularity = Zipf(d.courses.size(), cfg.course_zipf);
+        major_popularity = Zipf(departments.size(), 0.6);
+    }
+
+    void build_clubs() {
+        static const char* const kThemes[] = {
+            "athletics", "gaming", "music", "service", "outdoors", "tech",
+            "arts", "culture", "faith", "media", "wellness", "academic",
+        };
+        size_t members = cfg.students * cfg.clubs_per_resident + cfg.students / 2;
+        size_t clubs = members / std::max<size_t>(cfg.club_size, 1);
+        size_t per_theme = std::max<size_t>(3, clubs / std::size(kThemes));
+        for (const char* name : kThemes) themes.push_back({name, Zipf(per_theme, cfg.club_zipf)});
+        theme_popularity = Zipf(themes.size(), 0.5);
+    }
+
+    void fill(Resident& r, size_t i, Housing& housing) {
+        r.id = static_cast<uint32_t>(cfg.id_base + i);
+        r.name = name();
+        r.email = "r" + std::to_string(r.id) + "@housing.example.edu";
+        r.room = assign_room(housing);
+
+        uint32_t major = static_cast<uint32_t>(major_popularity(rng));
+        enroll(r, major);
+
+        size_t primary = theme_popularity(rng);
+        join_clubs(r, primary);
+
+        label(r, major, primary);
+
+        std::vector<TimeBlock> free;
+        if (!rng.chance(cfg.blank_availability_rate)) free = free_blocks(r.class_schedule);
+        r.set_free_blocks(std::move(free));
+
+        check_in(r);
+    }
+
+    std::string name() {
+        static const char* const kFirst[] = {
+            "Alex", "Jordan", "Sam", "Taylor", "Morgan", "Casey", "Riley", "Jamie",
+            "Avery", "Quinn", "Rowan", "Devon", "Priya", "Wei", "Mateo", "Amara",
+            "Noor", "Kenji", "Lucia", "Tariq",
+        };
+        static const char* const kLast[] = {
+            "Smith", "Nguyen", "Garcia", "Chen", "Okafor", "Patel", "Kim", "Rossi",
+            "Haddad", "Silva", "Novak", "Murphy", "Tanaka", "Cohen", "Mendez",
+            "Osei", "Ivanova", "Larsen", "Ahmed", "Brooks",
+        };
+        return std::string(kFirst[rng.below(std::size(kFirst))]) + " " +
+               kLast[rng.below(std::size(kLast))];
+    }
+
+    std::string assign_room(Housing& h) {
+        if (h.occupants == h.capacity) {
+            size_t n = h.room++;
+            size_t per_building = cfg.rooms_per_floor * cfg.floors_per_building;
+            size_t building = n / per_building;
+            size_t floor = (n % per_building) / cfg.rooms_per_floor + 1;
+            size_t room = n % cfg.rooms_per_floor + 1;
+
+            std::string number = std::to_string(floor * 100 + room);
+            std::string hall = std::to_string(building + 1);
+            if (hall.size() < 2) hall.insert(0, "0");
+            hall.insert(0, "B");
+            h.label = cfg.room_format == RoomFormat::NUMBER_FIRST ? number + "-" + hall
+                                                                  : hall + "-" + number;
+            h.capacity = rng.chance(cfg.single_room_rate) ? 1 : 2;
+            h.occupants = 0;
+        }
+        ++h.occupants;
+        return h.label;
+    }
+
+    void enroll(Resident& r, uint32_t major) {
+        size_t wanted = rng.between(cfg.min_classes, cfg.max_classes);
+        std::vector<uint32_t> taken;
+        for (size_t attempt = 0; attempt < wanted * 4 && taken.size() < wanted; ++attempt) {
+            const Department& d = departments[major];
+            uint32_t c = rng.chance(cfg.major_class_rate) && !d.courses.empty()
+                             ? d.courses[d.popularity(rng)]
+                             : static_cast<uint32_t>(course_popularity(rng));
+            if (std::find(taken.begin(), taken.end(), c) != taken.end()) continue;
+
+            const Course& course = courses[c];
+            size_t section = rng.below(course.sections) + 1;
+            std::string code = course.code + (section < 10 ? "-0" : "-") + std::to_string(section);
+            auto it = meetings.find(code);
+            if (it == meetings.end()) it = meetings.emplace(code, meeting_pattern()).first;
+
+            bool clash = false;
+            for (const auto& a : it->second) {
+                for (const auto& b : r.class_schedule) clash = clash || a.overlaps(b);
+            }
+            if (clash) continue;
+
+            taken.push_back(c);
+            r.classes.push_back(std::move(code));
+            r.class_schedule.insert(r.class_schedule.end(), it->second.begin(), it->second.end());
+        }
+    }
+
+    std::vector<TimeBlock> meeting_pattern() {
+        std::vector<TimeBlock> blocks;
+        auto add = [&](std::initializer_list<uint8_t> days, uint16_t start, uint16_t length) {
+            for (uint8_t d : days) blocks.push_back({d, start, static_cast<uint16_t>(start + length)});
+        };
+        switch (rng.below(3)) {
+            case 0:     // MWF, 50 minutes on the hour
+                add({0, 2, 4}, static_cast<uint16_t>((8 + rng.below(9)) * 60), 50);
+                break;
+            case 1:     // TTh, 75 minutes on the half-hour grid
+                add({1, 3}, static_cast<uint16_t>(kDayStart + rng.below(7) * 90), 75);
+                break;
+            default:    // MW, 75 minutes
+                add({0, 2}, static_cast<uint16_t>(kDayStart + rng.below(7) * 90), 75);
+                break;
+        }
+        return blocks;
+    }
+
+    void join_clubs(Resident& r, size_t primary) {
+        size_t wanted = rng.between(1, cfg.clubs_per_resident * 2);
+        for (size_t k = 0; k < wanted; ++k) {
+            size_t t = rng.chance(cfg.off_theme_rate) ? rng.below(themes.size()) : primary;
+            const Theme& theme = themes[t];
+            size_t club = theme.popularity(rng);
+            r.interests.insert(std::string(theme.name) + "_" + std::to_string(club + 1));
+        }
+    }
+
+    void label(Resident& r, uint32_t major, size_t primary) {
+        const std::string theme = themes[primary].name;
+        auto maybe = [&](const char* label, double p) {
+            if (rng.chance(p)) r.subcommunities.insert(label);
+        };
+        maybe("STEM", departments[major].stem ? 0.9 : 0.05);
+        maybe("athletes", theme == "athletics" ? 0.6 : 0.03);
+        maybe("gamers", theme == "gaming" ? 0.7 : theme == "tech" ? 0.4 : 0.05);
+        maybe("music", theme == "music" ? 0.6 : 0.03);
+        maybe("arts", theme == "arts" || theme == "media" ? 0.5 : 0.03);
+        maybe("honors", departments[major].stem ? 0.12 : 0.07);
+        maybe("international", 0.1);
+        maybe("first_gen", 0.15);
+    }
+
+    std::vector<TimeBlock> free_blocks(const std::vector<TimeBlock>& classes) {
+        std::vector<TimeBlock> blocks;
+        size_t wanted = rng.between(cfg.min_free_blocks, cfg.max_free_blocks);
+        for (size_t attempt = 0; attempt < wanted * 8 && blocks.size() < wanted; ++attempt) {
+            uint8_t day = static_cast<uint8_t>(rng.below(7));
+            uint16_t start = rng.chance(0.6)
+                ? static_cast<uint16_t>(17 * 60 + rng.below(17) * 15)       // 17:00-21:00
+                : static_cast<uint16_t>(kDayStart + rng.below(37) * 15);    // 8:00-17:00
+            uint16_t length = static_cast<uint16_t>(60 + rng.below(7) * 15);
+            TimeBlock b{day, start, static_cast<uint16_t>(std::min<int>(start + length, kDayEnd))};
+            if (b.end_min - b.start_min < 45) continue;
+
+            bool clash = false;
+            for (const auto& c : classes) clash = clash || b.overlaps(c);
+            for (const auto& f : blocks) clash = clash || b.overlaps(f);
+            if (!clash) blocks.push_back(b);
+        }
+        return blocks;
+    }
+
+    void check_in(Resident& r) {
+        // 0 = no check-in yet
+        static const double kRatingCdf[] = {0.10, 0.15, 0.25, 0.50, 0.80, 1.0};
+        double u = rng.real();
+        r.last_rating = 0;
+        while (r.last_rating < 5 && u >= kRatingCdf[r.last_rating]) ++r.last_rating;
+
+        bool low = r.last_rating > 0 && r.last_rating <= 2;
+        r.follow_up_needed = rng.chance(low ? cfg.low_rating_follow_up_rate : cfg.follow_up_rate);
+        if (r.follow_up_needed || (low && rng.chance(0.5))) {
+            static const char* const kConcerns[] = {
+                "homesick", "academic", "roommate", "health", "financial", "isolation",
+            };
+            size_t n = rng.between(1, 2);
+            for (size_t k = 0; k < n; ++k) r.concerns.insert(kConcerns[rng.below(std::size(kConcerns))]);
+        }
+    }
+};
+
+inline std::vector<Resident> generate_residents(const CampusConfig& config) {
+    return CampusGenerator(config).residents();
+}
+
+inline CommunityGraph generate_campus(const CampusConfig& config) {
+    return CampusGenerator(config).graph();
+}
+
+} // namespace bench
+} // namespace community_homology
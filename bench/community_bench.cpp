@@ -0,0 +1,329 @@
+// ============================================================================
+// COMMUNITY HOMOLOGY BENCHMARKS
+// ============================================================================
+//
+// Times every analysis stage on synthetic campuses from one floor up to the
+// configured maximum, and reports per iteration:
+//   allocs       operator new calls inside the stage
+//   alloc_MB     bytes requested from operator new inside the stage
+//   peak_rss_MB  process high-water mark while the stage ran (Linux resets
+//                it per benchmark through /proc/self/clear_refs)
+//   edges        connections in the graph the stage left behind
+//
+// Each iteration runs on a fresh copy of its input graph, made with the
+// clock paused, so stages that cache (CSR, flag complex) are measured cold
+// and stages that rebuild connections don't see the previous run.
+//
+// Environment:
+//   COMMUNITY_BENCH_MAX_RESIDENTS  largest campus to run (default 5000;
+//                                  100000 adds the whole-system scale)
+//   COMMUNITY_BENCH_SEED           generator seed (default 1)
+//
+// Built against Google Benchmark when CMake finds it, so the usual
+// --benchmark_filter / --benchmark_format flags apply. Otherwise a small
+// built-in runner prints the same counters as a table.
+
+#include "campus_generator.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+#if COMMUNITY_BENCH_GBENCH
+#include <benchmark/benchmark.h>
+#endif
+
+using namespace community_homology;
+
+// ============================================================================
+// ALLOCATION AND MEMORY COUNTERS
+// ============================================================================
+
+namespace {
+
+std::atomic<uint64_t> g_allocs{0};
+std::atomic<uint64_t> g_alloc_bytes{0};
+
+void* counted_alloc(size_t n, size_t align = 0) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    g_alloc_bytes.fetch_add(n, std::memory_order_relaxed);
+    if (n == 0) n = 1;
+    void* p = align ? std::aligned_alloc(align, (n + align - 1) / align * align) : std::malloc(n);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+struct AllocCount {
+    uint64_t allocs;
+    uint64_t bytes;
+
+    static AllocCount now() {
+        return {g_allocs.load(std::memory_order_relaxed),
+                g_alloc_bytes.load(std::memory_order_relaxed)};
+    }
+};
+
+// Starts a new high-water mark; a no-op where clear_refs is unavailable
+void reset_peak_rss() {
+    std::ofstream("/proc/self/clear_refs") << "5";
+}
+
+double peak_rss_mb() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmHWM:", 0) == 0) return std::strtod(line.c_str() + 6, nullptr) / 1024.0;
+    }
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0;
+}
+
+} // namespace
+
+void* operator new(size_t n) { return counted_alloc(n); }
+void* operator new[](size_t n) { return counted_alloc(n); }
+void* operator new(size_t n, std::align_val_t a) { return counted_alloc(n, static_cast<size_t>(a)); }
+void* operator new[](size_t n, std::align_val_t a) { return counted_alloc(n, static_cast<size_t>(a)); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+// ============================================================================
+// STAGES
+// ============================================================================
+
+namespace {
+
+enum class Input {
+    NONE,       // Stage builds its own graph
+    RESIDENTS,  // Residents only
+    CONNECTED   // After compute_connections
+};
+
+struct Stage {
+    const char* name;
+    Input input;
+    void (*run)(CommunityGraph& G, size_t residents);
+};
+
+volatile size_t g_sink = 0;
+
+uint64_t seed() {
+    const char* s = std::getenv("COMMUNITY_BENCH_SEED");
+    return s ? std::strtoull(s, nullptr, 10) : 1;
+}
+
+ThreadPool& pool() {
+    static ThreadPool p;
+    return p;
+}
+
+const Stage kStages[] = {
+    {"generate", Input::NONE, [](CommunityGraph& G, size_t n) {
+        G = bench::generate_campus(bench::CampusConfig::scaled(n, seed()));
+    }},
+    {"compute_connections", Input::RESIDENTS, [](CommunityGraph& G, size_t) {
+        G.compute_connections();
+    }},
+    {"compute_connections_pooled", Input::RESIDENTS, [](CommunityGraph& G, size_t) {
+        G.compute_connections(0.5f, CandidateMode::INDEXED, &pool());
+    }},
+    {"compute_connections_minhash", Input::RESIDENTS, [](CommunityGraph& G, size_t) {
+        G.compute_connections(0.5f, CandidateMode::MINHASH);
+    }},
+    {"topology", Input::CONNECTED, [](CommunityGraph& G, size_t) {
+        G.compute_boundary_scores();
+        G.compute_bridges();
+    }},
+    {"homology", Input::CONNECTED, [](CommunityGraph& G, size_t) {
+        g_sink = G.h0() + G.h1();
+    }},
+    {"find_cycles", Input::CONNECTED, [](CommunityGraph& G, size_t) {
+        g_sink = G.find_cycles().size();
+    }},
+    {"mayer_vietoris", Input::CONNECTED, [](CommunityGraph& G, size_t) {
+        g_sink = MayerVietorisEngine().compute(G, "STEM", "gamers").bridge_residents.size();
+    }},
+    {"mayer_vietoris_full", Input::RESIDENTS, [](CommunityGraph& G, size_t) {
+        g_sink = MayerVietorisEngine().compute_full(G).holes.size();
+    }},
+    {"persistence", Input::CONNECTED, [](CommunityGraph& G, size_t) {
+        g_sink = PersistentHomology().compute(G).barcodes.size();
+    }},
+    {"scheduling", Input::CONNECTED, [](CommunityGraph& G, size_t) {
+        g_sink = SchedulingOptimizer().find_optimal_event_times(G).size();
+    }},
+    {"analyze", Input::RESIDENTS, [](CommunityGraph& G, size_t) {
+        g_sink = CommunityAnalyzer().analyze(G).prioritized_checkins.size();
+    }},
+    {"analyze_pooled", Input::RESIDENTS, [](CommunityGraph& G, size_t) {
+        g_sink = CommunityAnalyzer(&pool()).analyze(G).prioritized_checkins.size();
+    }},
+};
+
+// Inputs for one campus size; benchmarks run size by size, so only the
+// current one is kept
+const CommunityGraph* input_graph(size_t residents, Input input) {
+    static size_t cached = 0;
+    static std::optional<CommunityGraph> raw;
+    static std::optional<CommunityGraph> connected;
+    if (input == Input::NONE) return nullptr;
+    if (cached != residents) {
+        raw.reset();
+        connected.reset();
+        raw = bench::generate_campus(bench::CampusConfig::scaled(residents, seed()));
+        cached = residents;
+    }
+    if (input == Input::RESIDENTS) return &*raw;
+    if (!connected) {
+        connected = *raw;
+        connected->compute_connections();
+    }
+    return &*connected;
+}
+
+std::vector<size_t> scales() {
+    const char* env = std::getenv("COMMUNITY_BENCH_MAX_RESIDENTS");
+    size_t limit = env ? std::strtoull(env, nullptr, 10) : bench::kCampusResidents;
+    std::vector<size_t> out;
+    for (size_t n : {bench::kFloorResidents, bench::kBuildingResidents,
+                     bench::kCampusResidents, bench::kSystemResidents}) {
+        if (n <= limit) out.push_back(n);
+    }
+    return out;
+}
+
+struct Totals {
+    uint64_t iterations = 0;
+    uint64_t allocs = 0;
+    uint64_t bytes = 0;
+    size_t edges = 0;
+};
+
+// One timed run on a fresh copy. The copy and its destruction stay outside
+// the clock and the counters; pause/resume bracket them.
+template <typename Pause, typename Resume>
+void run_stage(const Stage& stage, size_t residents, std::optional<CommunityGraph>& G,
+               Totals& totals, Pause pause, Resume resume) {
+    pause();
+    G.reset();
+    const CommunityGraph* input = input_graph(residents, stage.input);
+    if (input) G = *input; else G.emplace();
+    AllocCount before = AllocCount::now();
+    resume();
+
+    stage.run(*G, residents);
+
+    pause();
+    AllocCount after = AllocCount::now();
+    totals.iterations++;
+    totals.allocs += after.allocs - before.allocs;
+    totals.bytes += after.bytes - before.bytes;
+    totals.edges = G->connections.size();
+    resume();
+}
+
+} // namespace
+
+// ============================================================================
+// DRIVERS
+// ============================================================================
+
+#if COMMUNITY_BENCH_GBENCH
+
+namespace {
+
+void bench_stage(benchmark::State& state, const Stage* stage, size_t residents) {
+    input_graph(residents, stage->input);   // Generate outside the measurement
+    std::optional<CommunityGraph> G;
+    Totals totals;
+    reset_peak_rss();
+    for (auto _ : state) {
+        run_stage(*stage, residents, G, totals,
+                  [&] { state.PauseTiming(); }, [&] { state.ResumeTiming(); });
+    }
+    double peak = peak_rss_mb();
+    G.reset();
+
+    using benchmark::Counter;
+    double n = static_cast<double>(std::max<uint64_t>(totals.iterations, 1));
+    state.counters["allocs"] = Counter(totals.allocs / n);
+    state.counters["alloc_MB"] = Counter(totals.bytes / n / (1024.0 * 1024.0));
+    state.counters["peak_rss_MB"] = Counter(peak);
+    state.counters["edges"] = Counter(static_cast<double>(totals.edges));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    for (size_t n : scales()) {
+        for (const Stage& stage : kStages) {
+            std::string name = std::string(stage.name) + "/" + std::to_string(n);
+            benchmark::RegisterBenchmark(name.c_str(), bench_stage, &stage, n)
+                ->Unit(benchmark::kMillisecond)
+                ->UseRealTime();
+        }
+    }
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
+
+#else
+
+// Repeats each stage until it has run for a fifth of a second (at least once)
+int main() {
+    using Clock = std::chrono::steady_clock;
+    std::printf("%-28s %9s %12s %12s %10s %12s %10s\n",
+                "stage", "residents", "ms/iter", "allocs", "alloc_MB", "peak_rss_MB", "edges");
+    for (size_t n : scales()) {
+        for (const Stage& stage : kStages) {
+            input_graph(n, stage.input);
+            std::optional<CommunityGraph> G;
+            Totals totals;
+            Clock::duration elapsed{};
+            Clock::time_point start;
+            bool running = false;
+            reset_peak_rss();
+            while (totals.iterations == 0 ||
+                   (elapsed < std::chrono::milliseconds(200) && totals.iterations < 1000)) {
+                run_stage(stage, n, G, totals,
+                          [&] {
+                              if (running) elapsed += Clock::now() - start;
+                              running = false;
+                          },
+                          [&] {
+                              start = Clock::now();
+                              running = true;
+                          });
+            }
+            double peak = peak_rss_mb();
+            G.reset();
+
+            double iters = static_cast<double>(totals.iterations);
+            double ms = std::chrono::duration<double, std::milli>(elapsed).count() / iters;
+            std::printf("%-28s %9zu %12.3f %12.0f %10.2f %12.1f %10zu\n",
+                        stage.name, n, ms, totals.allocs / iters,
+                        totals.bytes / iters / (1024.0 * 1024.0), peak, totals.edges);
+        }
+    }
+    return 0;
+}
+
+#endif
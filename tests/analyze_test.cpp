@@ -0,0 +1,89 @@
+// ============================================================================
+// POOLED ANALYSIS
+// ============================================================================
+//
+// CommunityAnalyzer promises that a pooled run matches a serial one: the
+// same connections, and the same homology, persistence, scheduling and
+// check-in results. AnalysisArena runs, serial and pooled, must agree too.
+
+#include "test_support.hpp"
+
+using namespace community_homology;
+
+namespace {
+
+template <class A, class B>
+bool same_lists(const A& a, const B& b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end());
+}
+
+void check_same(const CommunityAnalysis& a, const CommunityAnalysis& b) {
+    const auto& x = a.homology;
+    const auto& y = b.homology;
+    CHECK(x.h0_A == y.h0_A);
+    CHECK(x.h1_union == y.h1_union);
+    CHECK(x.is_cohesive == y.is_cohesive);
+    CHECK(x.community_health == y.community_health);
+    CHECK(same_lists(x.isolation_risk, y.isolation_risk));
+    CHECK(same_lists(x.bridge_residents, y.bridge_residents));
+    CHECK(x.holes == y.holes);
+    CHECK(same_lists(x.suggested_introductions, y.suggested_introductions));
+    CHECK(x.diagnosis == y.diagnosis);
+
+    const auto& p = a.persistence;
+    const auto& q = b.persistence;
+    CHECK(p.barcodes.size() == q.barcodes.size());
+    for (size_t k = 0; k < std::min(p.barcodes.size(), q.barcodes.size()); ++k) {
+        CHECK(p.barcodes[k].dimension == q.barcodes[k].dimension);
+        CHECK(p.barcodes[k].birth == q.barcodes[k].birth);
+        CHECK(p.barcodes[k].death == q.barcodes[k].death);
+        CHECK(p.barcodes[k].residents == q.barcodes[k].residents);
+    }
+    CHECK(p.stable_groups == q.stable_groups);
+    CHECK(p.fragile_groups == q.fragile_groups);
+
+    CHECK(a.optimal_event_times.size() == b.optimal_event_times.size());
+    for (size_t k = 0; k < std::min(a.optimal_event_times.size(), b.optimal_event_times.size()); ++k) {
+        const auto& s = a.optimal_event_times[k];
+        const auto& t = b.optimal_event_times[k];
+        CHECK(s.slot.day == t.slot.day && s.slot.start_min == t.slot.start_min);
+        CHECK(s.topology_score == t.topology_score);
+        CHECK(s.available_residents == t.available_residents);
+    }
+
+    CHECK(a.prioritized_checkins == b.prioritized_checkins);
+    CHECK(a.health_score == b.health_score);
+    CHECK(a.isolation_count == b.isolation_count);
+    CHECK(a.bridge_count == b.bridge_count);
+    CHECK(a.hole_count == b.hole_count);
+}
+
+} // namespace
+
+int main() {
+    for (uint64_t seed : {1, 2}) {
+        auto residents = bench::generate_residents(bench::CampusConfig::scaled(400, seed));
+
+        CommunityGraph serial_graph;
+        for (const auto& r : residents) serial_graph.add_resident(r);
+        CommunityAnalysis serial = CommunityAnalyzer().analyze(serial_graph);
+        CHECK(!serial_graph.connections.empty());
+        CHECK(serial.hole_count > 0 && !serial.persistence.barcodes.empty());
+
+        ThreadPool pool(3);
+        CommunityGraph pooled_graph;
+        for (const auto& r : residents) pooled_graph.add_resident(r);
+        CommunityAnalysis pooled = CommunityAnalyzer(&pool).analyze(pooled_graph);
+        CHECK(test::same_connections(serial_graph, pooled_graph));
+        check_same(serial, pooled);
+
+        for (ThreadPool* arena_pool : {static_cast<ThreadPool*>(nullptr), &pool}) {
+            AnalysisArena run;
+            for (const auto& r : residents) run.graph().add_resident(r);
+            CommunityAnalysis in_arena = run.analyze(arena_pool);
+            CHECK(test::same_connections(serial_graph, run.graph()));
+            check_same(serial, in_arena);
+        }
+    }
+    return test::finish("analyze_test");
+}
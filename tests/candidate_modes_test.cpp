@@ -0,0 +1,82 @@
+// ============================================================================
+// CANDIDATE MODES AND SCORING POLICIES
+// ============================================================================
+//
+// INDEXED must emit exactly the BRUTE_FORCE edges, in the same order, under
+// the constant kernel, runtime weights and a compile-time policy, serial or
+// pooled. MINHASH may miss edges but must never invent one or score it
+// differently. A compile-time policy must match the same weights given at
+// run time.
+
+#include "test_support.hpp"
+
+using namespace community_homology;
+
+namespace {
+
+struct NoSchedule : DefaultScoring {
+    static constexpr float schedule_cap = 0.0f;
+};
+
+CommunityGraph build(const std::vector<Resident>& residents, const ScoringWeights& weights) {
+    CommunityGraph G;
+    G.scoring = weights;
+    for (const auto& r : residents) G.add_resident(r);
+    return G;
+}
+
+void check_modes(const std::vector<Resident>& residents, const ScoringWeights& weights, ThreadPool* pool) {
+    const float min_strength = 0.5f;
+    CommunityGraph brute = build(residents, weights);
+    brute.compute_connections(min_strength, CandidateMode::BRUTE_FORCE, pool);
+    CHECK(!brute.connections.empty());
+
+    CommunityGraph indexed = build(residents, weights);
+    indexed.compute_connections(min_strength, CandidateMode::INDEXED, pool);
+    CHECK(test::same_connections(brute, indexed));
+
+    CommunityGraph minhash = build(residents, weights);
+    minhash.compute_connections(min_strength, CandidateMode::MINHASH, pool);
+    std::map<std::pair<uint32_t, uint32_t>, const Connection*> reference;
+    for (const auto& c : brute.connections) reference[{c.source, c.target}] = &c;
+    size_t found = 0;
+    for (const auto& c : minhash.connections) {
+        auto it = reference.find({c.source, c.target});
+        CHECK(it != reference.end());
+        if (it == reference.end()) continue;
+        CHECK(it->second->strength == c.strength && it->second->types == c.types);
+        ++found;
+    }
+    // About 90% of the edges on this campus; the floor leaves some slack
+    CHECK(found * 10 >= brute.connections.size() * 7);
+}
+
+} // namespace
+
+int main() {
+    ThreadPool pool(3);
+    auto residents = bench::generate_residents(bench::CampusConfig::scaled(600, 5));
+
+    ScoringWeights defaults;
+    ScoringWeights custom;
+    custom.shared_class = 1.5f;
+    custom.shared_interest = 1.25f;
+    custom.floor_proximity = 0.0f;
+    for (const ScoringWeights* weights : {&defaults, &custom}) {
+        check_modes(residents, *weights, nullptr);
+        check_modes(residents, *weights, &pool);
+    }
+
+    // A compile-time policy, indexed or not, matches the runtime weights
+    ScoringWeights no_schedule;
+    no_schedule.schedule_cap = 0.0f;
+    CommunityGraph runtime = build(residents, no_schedule);
+    runtime.compute_connections(0.5f, CandidateMode::BRUTE_FORCE);
+    for (CandidateMode mode : {CandidateMode::BRUTE_FORCE, CandidateMode::INDEXED}) {
+        CommunityGraph policy = build(residents, ScoringWeights());
+        policy.compute_connections_with(NoSchedule(), 0.5f, mode, &pool);
+        CHECK(test::same_connections(runtime, policy));
+    }
+
+    return test::finish("candidate_modes_test");
+}
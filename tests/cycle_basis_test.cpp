@@ -0,0 +1,121 @@
+// ============================================================================
+// CYCLE BASES
+// ============================================================================
+//
+// On random graphs small enough to enumerate their whole cycle space,
+// CycleBasis::minimum must return β₁ independent simple cycles whose total
+// cost equals the optimum found by greedy elimination over every cycle
+// space element, under both CycleCost models. On a campus the streaming,
+// materialized and top-k cycle queries must agree with h1().
+
+#include "test_support.hpp"
+
+#include <random>
+
+using namespace community_homology;
+
+namespace {
+
+// Reduces v against a GF(2) basis kept sorted high to low; nonzero if
+// independent (the basis then takes it)
+bool insert_independent(std::vector<uint32_t>& basis, uint32_t v) {
+    for (uint32_t b : basis) v = std::min(v, v ^ b);
+    if (v == 0) return false;
+    basis.push_back(v);
+    std::sort(basis.rbegin(), basis.rend());
+    return true;
+}
+
+void check_minimum_on_random_graphs() {
+    std::mt19937 rng(7);
+    for (int round = 0; round < 400; ++round) {
+        const uint32_t V = 3 + rng() % 6;
+        std::vector<std::pair<uint32_t, uint32_t>> ends;
+        for (uint32_t a = 0; a < V; ++a) {
+            for (uint32_t b = a + 1; b < V; ++b) {
+                if (rng() % 100 < 45 && ends.size() < 14) ends.emplace_back(a, b);
+            }
+        }
+        const uint32_t E = static_cast<uint32_t>(ends.size());
+        CsrAdjacency g = CsrAdjacency::from_edges(V, ends);
+        std::vector<float> strength(E);
+        for (auto& s : strength) s = round % 3 == 0 ? (rng() % 3) * 0.5f : (rng() % 1000) / 100.0f;
+        for (size_t k = 0; k < g.edges.size(); ++k) g.weights[k] = strength[g.edges[k]];
+        std::map<std::pair<uint32_t, uint32_t>, uint32_t> edge_of;
+        for (uint32_t e = 0; e < E; ++e) edge_of[ends[e]] = e;
+
+        for (CycleCost cost : {CycleCost::LENGTH, CycleCost::STRENGTH}) {
+            auto weight = [&](uint32_t e) { return cost == CycleCost::LENGTH ? 1.0 : double(strength[e]); };
+
+            // Optimum: greedy over every even-degree edge set, cheapest first
+            std::vector<std::pair<double, uint32_t>> elements;
+            for (uint32_t set = 1; set < (1u << E); ++set) {
+                std::vector<int> degree(V, 0);
+                double total = 0.0;
+                for (uint32_t e = 0; e < E; ++e) {
+                    if (!(set >> e & 1)) continue;
+                    ++degree[ends[e].first];
+                    ++degree[ends[e].second];
+                    total += weight(e);
+                }
+                if (std::all_of(degree.begin(), degree.end(), [](int d) { return d % 2 == 0; })) {
+                    elements.emplace_back(total, set);
+                }
+            }
+            std::sort(elements.begin(), elements.end());
+            std::vector<uint32_t> optimum_basis;
+            double optimum = 0.0;
+            for (const auto& [total, set] : elements) {
+                if (insert_independent(optimum_basis, set)) optimum += total;
+            }
+
+            auto cycles = CycleBasis::minimum(g, CycleBasis::kMinimumBasisMaxVertices, cost);
+            CHECK(cycles.size() == optimum_basis.size());
+            std::vector<uint32_t> basis;
+            double total = 0.0;
+            for (const auto& cycle : cycles) {
+                uint32_t set = 0;
+                for (size_t i = 0; i < cycle.size(); ++i) {
+                    auto key = std::minmax(cycle[i], cycle[(i + 1) % cycle.size()]);
+                    auto it = edge_of.find({key.first, key.second});
+                    CHECK(it != edge_of.end());
+                    if (it == edge_of.end()) continue;
+                    CHECK(!(set >> it->second & 1));  // Simple: no edge twice
+                    set |= 1u << it->second;
+                    total += weight(it->second);
+                }
+                CHECK(insert_independent(basis, set));
+            }
+            CHECK(std::abs(total - optimum) < 1e-4);
+        }
+    }
+}
+
+void check_campus_queries() {
+    CommunityGraph G = bench::generate_campus(bench::CampusConfig::scaled(200, 4));
+    G.compute_connections(2.0f);
+    const size_t h1 = static_cast<size_t>(G.h1());
+    CHECK(h1 > 0);
+
+    auto cycles = G.find_cycles();
+    CHECK(cycles.size() == h1);
+    size_t streamed = 0;
+    G.for_each_cycle([&](const std::vector<uint32_t>& ids) {
+        CHECK(streamed < cycles.size() && ids == cycles[streamed]);
+        ++streamed;
+    });
+    CHECK(streamed == h1);
+
+    auto shortest = G.shortest_cycles(5);
+    CHECK(shortest.size() == std::min<size_t>(5, h1));
+    for (size_t k = 1; k < shortest.size(); ++k) CHECK(shortest[k - 1].size() <= shortest[k].size());
+    CHECK(G.minimum_cycle_basis().size() == h1);
+}
+
+} // namespace
+
+int main() {
+    check_minimum_on_random_graphs();
+    check_campus_queries();
+    return test::finish("cycle_basis_test");
+}
@@ -0,0 +1,40 @@
+// ============================================================================
+// MAYER-VIETORIS INVARIANTS
+// ============================================================================
+//
+// With A = B = the whole community, A ∩ B and A ∪ B are the community too,
+// so MayerVietorisEngine::compute must report the same β₀ and β₁ for A, for
+// the intersection and for the union, under both homology models.
+
+#include "test_support.hpp"
+
+using namespace community_homology;
+
+int main() {
+    for (size_t n : {60, 300}) {
+        CommunityGraph G;
+        for (auto r : bench::generate_residents(bench::CampusConfig::scaled(n, 7))) {
+            r.subcommunities.insert("all");
+            G.add_resident(r);
+        }
+        G.compute_connections(1.5f);
+        CHECK(!G.connections.empty());
+
+        int h1[2] = {0, 0};
+        for (HomologyModel model : {HomologyModel::GRAPH, HomologyModel::FLAG_COMPLEX}) {
+            G.homology_model = model;
+            MayerVietorisEngine::Result whole = MayerVietorisEngine().compute(G, "all", "all");
+            CHECK(whole.h1_A == whole.h1_union);
+            CHECK(whole.h1_B == whole.h1_union);
+            CHECK(whole.h1_intersection == whole.h1_union);
+            CHECK(whole.h0_A == G.h0());
+            CHECK(whole.h0_intersection == G.h0());
+            CHECK(whole.kernel_i0 == 0);
+            CHECK(whole.holes.size() == static_cast<size_t>(whole.h1_union));
+            h1[model == HomologyModel::FLAG_COMPLEX] = whole.h1_union;
+        }
+        // Filling triangles can only close holes
+        CHECK(h1[1] <= h1[0]);
+    }
+    return test::finish("homology_test");
+}
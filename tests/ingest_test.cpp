@@ -0,0 +1,76 @@
+// ============================================================================
+// RESIDENT INGESTION
+// ============================================================================
+//
+// add_resident may be handed an element of the graph's own roster while
+// the roster is full, so growing it reallocates the argument away; the
+// newcomer must still be an exact copy. An emplace_resident whose fill
+// throws must leave the roster as it was.
+
+#include "test_support.hpp"
+
+#include <stdexcept>
+
+using namespace community_homology;
+
+namespace {
+
+bool same_resident(const Resident& a, const Resident& b) {
+    auto same_blocks = [](const std::vector<TimeBlock>& x, const std::vector<TimeBlock>& y) {
+        return std::equal(x.begin(), x.end(), y.begin(), y.end(), [](const TimeBlock& p, const TimeBlock& q) {
+            return p.day == q.day && p.start_min == q.start_min && p.end_min == q.end_min;
+        });
+    };
+    return a.id == b.id && a.name == b.name && a.room == b.room && a.email == b.email &&
+           a.subcommunities == b.subcommunities && a.classes == b.classes && a.interests == b.interests &&
+           a.concerns == b.concerns && same_blocks(a.free_blocks, b.free_blocks) &&
+           a.room_id == b.room_id && a.class_ids == b.class_ids && a.interest_ids == b.interest_ids &&
+           a.subcommunity_ids == b.subcommunity_ids;
+}
+
+} // namespace
+
+int main() {
+    CommunityGraph G;
+    for (const auto& r : bench::generate_residents(bench::CampusConfig::scaled(50, 2))) G.add_resident(r);
+
+    for (size_t k : {size_t(0), size_t(17), G.residents.size() - 1}) {
+        G.residents.shrink_to_fit();
+        CHECK(G.residents.size() == G.residents.capacity());
+        Resident original = G.residents[k];
+        const size_t before = G.residents.size();
+        G.add_resident(G.residents[k]);
+        CHECK(G.residents.size() == before + 1);
+        CHECK(same_resident(G.residents.back(), original));
+        CHECK(same_resident(G.residents[k], original));
+    }
+
+    const size_t before = G.residents.size();
+    const auto labels = G.subcommunity_labels;
+    const auto members = G.subcommunity_members;
+    bool thrown = false;
+    try {
+        G.emplace_resident([](Resident& r) {
+            r.id = 1;
+            r.subcommunities.insert("never_booked");
+            throw std::runtime_error("bad row");
+        });
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    CHECK(thrown);
+    CHECK(G.residents.size() == before);
+    CHECK(G.subcommunity_labels == labels);
+    CHECK(G.subcommunity_members == members);
+    CHECK(G.index(1) == CommunityGraph::npos);
+
+    // The roster still takes residents and analyzes
+    Resident extra = G.residents[0];
+    extra.id = 1;
+    G.add_resident(extra);
+    CHECK(G.index(1) == G.residents.size() - 1);
+    G.compute_connections();
+    CHECK(G.h0() >= 1);
+
+    return test::finish("ingest_test");
+}
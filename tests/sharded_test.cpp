@@ -0,0 +1,126 @@
+// ============================================================================
+// SHARDED CAMPUS
+// ============================================================================
+//
+// With schedule overlap switched off, every cross-building edge rests on a
+// shared class or interest, and building-first room labels carry no floor
+// number, so ShardedCampus must find exactly the graph one CommunityGraph
+// over everybody finds: the same connection count, β₀, β₁ and bridge
+// residents. With the default weights the merge must still match the
+// union of the shard edges and the exchanged ones.
+
+#include "test_support.hpp"
+
+using namespace community_homology;
+
+namespace {
+
+std::vector<Resident> campus(uint64_t seed) {
+    auto config = bench::CampusConfig::scaled(900, seed);
+    config.room_format = bench::RoomFormat::BUILDING_FIRST;
+    return bench::generate_residents(config);
+}
+
+void check_against_single_graph(const std::vector<Resident>& residents, ShardedCampus::Partition by,
+                                float min_strength, ThreadPool* pool) {
+    ScoringWeights weights;
+    weights.schedule_cap = 0.0f;
+
+    ShardedCampus::Options options;
+    options.by = by;
+    options.min_strength = min_strength;
+    options.scoring = weights;
+    ShardedCampus sharded(options);
+    for (const auto& r : residents) CHECK(sharded.add_resident(r));
+    ShardedCampus::Result result = sharded.analyze(pool);
+
+    CommunityGraph G;
+    G.scoring = weights;
+    for (const auto& r : residents) G.add_resident(r);
+    G.compute_connections(min_strength);
+    G.compute_bridges();
+    std::vector<uint32_t> bridges = G.get_bridge_residents();
+    std::sort(bridges.begin(), bridges.end());
+
+    CHECK(result.shards > 1);
+    CHECK(result.residents == residents.size());
+    CHECK(result.connections == G.connections.size());
+    CHECK(result.h0 == G.h0());
+    CHECK(result.h1 == G.h1());
+    CHECK(result.bridge_residents == bridges);
+}
+
+// Default weights: the reference is the union graph of what the shards and
+// the exchange produced
+void check_against_union(const std::vector<Resident>& residents) {
+    ShardedCampus sharded;
+    for (const auto& r : residents) sharded.add_resident(r);
+    ShardedCampus::Result result = sharded.analyze();
+
+    CommunityGraph U;
+    for (const auto& r : residents) U.add_resident(r);
+    for (const auto& shard : sharded.shards()) {
+        for (const auto& c : shard.graph.connections) U.add_connection(c.source, c.target, c.type, c.strength);
+    }
+    for (const auto& c : result.cross_edges) U.add_connection(c.source, c.target, c.type, c.strength);
+    U.compute_bridges();
+    std::vector<uint32_t> bridges = U.get_bridge_residents();
+    std::sort(bridges.begin(), bridges.end());
+
+    CHECK(result.connections == U.connections.size());
+    CHECK(result.h0 == U.h0());
+    CHECK(result.h1 == U.h1());
+    CHECK(result.bridge_residents == bridges);
+}
+
+// MINHASH exchange edges are a subset of the INDEXED ones, scored the same
+void check_exchange_modes(const std::vector<Resident>& residents) {
+    ShardedCampus sharded;
+    for (const auto& r : residents) sharded.add_resident(r);
+    std::vector<std::vector<std::string>> published;
+    for (const auto& shard : sharded.shards()) published.push_back(ShardedCampus::keys(shard.graph));
+    auto cross = ShardedCampus::cross_keys(published);
+    std::vector<std::vector<Resident>> exported;
+    for (const auto& shard : sharded.shards()) exported.push_back(ShardedCampus::export_features(shard.graph, cross));
+
+    auto indexed = ShardedCampus::exchange(exported, cross);
+    auto minhash = ShardedCampus::exchange(exported, cross, 0.5f, ScoringWeights(), CandidateMode::MINHASH);
+    CHECK(!indexed.empty());
+    CHECK(!minhash.empty() && minhash.size() <= indexed.size());
+    auto before = [](const Connection& a, const Connection& b) {
+        return a.source != b.source ? a.source < b.source : a.target < b.target;
+    };
+    CHECK(std::is_sorted(indexed.begin(), indexed.end(), before));
+    for (size_t e = 0; e < indexed.size(); ++e) CHECK(indexed[e].id == e);
+    for (const auto& c : minhash) {
+        auto it = std::lower_bound(indexed.begin(), indexed.end(), c, before);
+        CHECK(it != indexed.end() && it->source == c.source && it->target == c.target);
+        if (it != indexed.end()) CHECK(it->strength == c.strength && it->types == c.types);
+    }
+}
+
+} // namespace
+
+int main() {
+    ThreadPool pool(2);
+    auto residents = campus(1);
+    for (auto by : {ShardedCampus::Partition::BUILDING, ShardedCampus::Partition::FLOOR}) {
+        for (float min_strength : {2.0f, 3.0f}) {
+            check_against_single_graph(residents, by, min_strength, nullptr);
+        }
+    }
+    check_against_single_graph(campus(2), ShardedCampus::Partition::BUILDING, 3.0f, &pool);
+    check_against_union(residents);
+    check_exchange_modes(residents);
+
+    // The merge tells residents apart by ID, so a repeat is refused
+    ShardedCampus sharded;
+    CHECK(sharded.add_resident(residents[0]));
+    Resident moved = residents[0];
+    moved.room = residents.back().room;
+    CHECK(ShardedCampus::shard_key(moved.room) != ShardedCampus::shard_key(residents[0].room));
+    CHECK(!sharded.add_resident(moved));
+    CHECK(sharded.shards().size() == 1 && sharded.shards()[0].graph.residents.size() == 1);
+
+    return test::finish("sharded_test");
+}
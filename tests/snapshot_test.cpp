@@ -0,0 +1,119 @@
+// ============================================================================
+// SNAPSHOT ROUND TRIP
+// ============================================================================
+//
+// save_snapshot then load_snapshot must give back the same residents, the
+// same connections with their subcommunity masks and label sets (including
+// labels past kSubcommunityMaskBits), the same CSR and edge columns, and
+// the same topology. A file with a flipped byte must be rejected.
+
+#include "test_support.hpp"
+
+#include <fstream>
+
+using namespace community_homology;
+
+namespace {
+
+bool same_blocks(const std::vector<TimeBlock>& a, const std::vector<TimeBlock>& b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const TimeBlock& x, const TimeBlock& y) {
+        return x.day == y.day && x.start_min == y.start_min && x.end_min == y.end_min;
+    });
+}
+
+void check_residents(const CommunityGraph& a, const CommunityGraph& b) {
+    CHECK(a.residents.size() == b.residents.size());
+    for (size_t i = 0; i < std::min(a.residents.size(), b.residents.size()); ++i) {
+        const Resident& x = a.residents[i];
+        const Resident& y = b.residents[i];
+        CHECK(x.id == y.id);
+        CHECK(x.name == y.name && x.room == y.room && x.email == y.email && x.phone == y.phone);
+        CHECK(x.subcommunities == y.subcommunities);
+        CHECK(x.classes == y.classes);
+        CHECK(x.interests == y.interests);
+        CHECK(x.concerns == y.concerns);
+        CHECK(same_blocks(x.class_schedule, y.class_schedule));
+        CHECK(same_blocks(x.free_blocks, y.free_blocks));
+        CHECK(x.last_rating == y.last_rating && x.follow_up_needed == y.follow_up_needed);
+        CHECK(x.boundary_score == y.boundary_score && x.is_bridge == y.is_bridge);
+        CHECK(x.component_id == y.component_id);
+    }
+}
+
+void check_edges(const CommunityGraph& a, const CommunityGraph& b) {
+    CHECK(test::same_connections(a, b));
+    for (size_t e = 0; e < std::min(a.connections.size(), b.connections.size()); ++e) {
+        const Connection& x = a.connections[e];
+        const Connection& y = b.connections[e];
+        CHECK(x.subcommunity_mask == y.subcommunity_mask);
+        CHECK(x.is_bridge_edge == y.is_bridge_edge && x.crosses_boundary == y.crosses_boundary);
+        CHECK(a.touched_subcommunities(x) == b.touched_subcommunities(y));
+    }
+
+    const CsrAdjacency& g = a.adjacency();
+    const CsrAdjacency& h = b.adjacency();
+    CHECK(g.offsets == h.offsets && g.neighbors == h.neighbors && g.weights == h.weights && g.edges == h.edges);
+    const EdgeStore& s = a.edge_store();
+    const EdgeStore& t = b.edge_store();
+    CHECK(s.source == t.source && s.target == t.target && s.strength == t.strength);
+    CHECK(s.types == t.types && s.subcommunities == t.subcommunities);
+}
+
+} // namespace
+
+int main() {
+    const std::string path = "snapshot_test.snap";
+    CommunityGraph G = bench::generate_campus(bench::CampusConfig::scaled(300, 3));
+
+    // More labels than the mask holds, so both halves of the label lookup
+    // are exercised
+    for (size_t k = 0; k < G.residents.size(); ++k) {
+        Resident r = G.residents[k];
+        for (size_t j = 0; j < 3; ++j) r.subcommunities.insert("L" + std::to_string((k * 7 + j * 13) % 90));
+        G.update_resident(r);
+    }
+    G.compute_connections(1.5f);
+    G.compute_boundary_scores();
+    G.compute_bridges();
+    CHECK(G.subcommunity_symbols.size() > kSubcommunityMaskBits);
+    CHECK(!G.connections.empty());
+
+    std::string error;
+    CHECK(G.save_snapshot(path, &error));
+    CommunityGraph L;
+    CHECK(L.load_snapshot(path, &error));
+    CHECK(error.empty());
+
+    check_residents(G, L);
+    check_edges(G, L);
+    CHECK(G.h0() == L.h0() && G.h1() == L.h1());
+    CHECK(G.find_cycles() == L.find_cycles());
+    CHECK(G.get_bridge_residents() == L.get_bridge_residents());
+
+    // A loaded graph keeps working: a new connection links in both
+    uint32_t a = G.residents[0].id, b = G.residents[G.residents.size() - 1].id;
+    G.add_connection(a, b);
+    L.add_connection(a, b);
+    check_edges(G, L);
+    CHECK(G.h1() == L.h1());
+
+    // One flipped byte past the header fails the checksum
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekg(0, std::ios::end);
+        std::streamoff size = file.tellg();
+        file.seekg(size / 2);
+        char byte = 0;
+        file.read(&byte, 1);
+        byte = static_cast<char>(byte ^ 0x5A);
+        file.seekp(size / 2);
+        file.write(&byte, 1);
+    }
+    CommunityGraph corrupt;
+    error.clear();
+    CHECK(!corrupt.load_snapshot(path, &error));
+    CHECK(!error.empty());
+
+    std::remove(path.c_str());
+    return test::finish("snapshot_test");
+}
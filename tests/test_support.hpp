@@ -0,0 +1,55 @@
+// ============================================================================
+// TEST SUPPORT
+// ============================================================================
+//
+// CHECK records a failure and keeps going, so one run reports every broken
+// case; finish() prints the tally and gives main its exit code.
+
+#pragma once
+
+#include "campus_generator.hpp"
+
+#include <cstdio>
+
+namespace test {
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+inline void fail(const char* file, int line, const char* expression) {
+    std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, expression);
+    ++failures();
+}
+
+inline int finish(const char* name) {
+    if (failures() != 0) {
+        std::fprintf(stderr, "%s: %d check(s) failed\n", name, failures());
+        return 1;
+    }
+    std::printf("%s: ok\n", name);
+    return 0;
+}
+
+// Edge lists compared as data: ids, ends, strength and types
+inline bool same_connections(const community_homology::CommunityGraph& a,
+                             const community_homology::CommunityGraph& b) {
+    if (a.connections.size() != b.connections.size()) return false;
+    for (size_t e = 0; e < a.connections.size(); ++e) {
+        const auto& x = a.connections[e];
+        const auto& y = b.connections[e];
+        if (x.id != y.id || x.source != y.source || x.target != y.target || x.strength != y.strength ||
+            x.type != y.type || x.types != y.types) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace test
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) ::test::fail(__FILE__, __LINE__, #condition); \
+    } while (0)